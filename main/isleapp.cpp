@@ -4,6 +4,9 @@
 #include "esp_log.h"
 
 #include "isleapp.h"
+#include "islefiles.h"
+#include "isleprofile.h"
+#include "islereplay.h"
 
 #include "3dmanager/lego3dmanager.h"
 #include "decomp.h"
@@ -49,12 +52,6 @@ DECOMP_SIZE_ASSERT(IsleApp, 0x8c)
 // GLOBAL: ISLE 0x410030
 IsleApp* g_isle = NULL;
 
-// GLOBAL: ISLE 0x410034
-MxU8 g_mousedown = FALSE;
-
-// GLOBAL: ISLE 0x410038
-MxU8 g_mousemoved = FALSE;
-
 // GLOBAL: ISLE 0x41003c
 MxS32 g_closed = FALSE;
 
@@ -73,9 +70,73 @@ MxS32 g_reqEnableRMDevice = FALSE;
 // STRING: ISLE 0x4101dc
 #define WINDOW_TITLE "LEGO®"
 
+// A single tickle taking longer than this gets logged as a stall.
+#define TICKLE_STALL_MS 250
+
+// Time between the first frame and the initial action, see Tick().
+#define STARTUP_DELAY_MS 2000
+
 SDL_Window* window;
 
-extern const char* g_files[46];
+static void LogBootStage(const char* p_stage)
+{
+	ESP_LOGI(TAG, "Boot: %s at %" PRIu32 " ms", p_stage, esp_log_timestamp());
+}
+
+static int SDLCALL VerifyFilesystemThread(void* p_data)
+{
+	MxResult result = static_cast<IsleApp*>(p_data)->VerifyFilesystem();
+	LogBootStage("Filesystem verified");
+	return result;
+}
+
+static int SDLCALL LoadSavesThread(void* p_data)
+{
+	GameState()->SerializePlayersInfo(LegoStorage::c_read);
+	GameState()->SerializeScoreHistory(LegoStorage::c_read);
+	LogBootStage("Saves loaded");
+	return 0;
+}
+
+static void ResetReplaySavePath(const char* p_path)
+{
+	SDL_CreateDirectory(p_path);
+
+	int count = 0;
+	char** entries = SDL_GlobDirectory(p_path, NULL, 0, &count);
+	if (!entries) {
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		MxString path(p_path);
+		path += entries[i];
+
+		if (!SDL_RemovePath(path.GetData())) {
+			SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Failed to remove '%s': %s", path.GetData(), SDL_GetError());
+		}
+	}
+
+	SDL_free(entries);
+}
+
+static SDL_Thread* CreateBootThread(SDL_ThreadFunction p_fn, const char* p_name, void* p_data)
+{
+	SDL_PropertiesID props = SDL_CreateProperties();
+	SDL_SetPointerProperty(props, SDL_PROP_THREAD_CREATE_ENTRY_FUNCTION_POINTER, (void*) p_fn);
+	SDL_SetStringProperty(props, SDL_PROP_THREAD_CREATE_NAME_STRING, p_name);
+	SDL_SetPointerProperty(props, SDL_PROP_THREAD_CREATE_USERDATA_POINTER, p_data);
+	SDL_SetNumberProperty(props, SDL_PROP_THREAD_CREATE_STACKSIZE_NUMBER, 8192);
+
+	SDL_Thread* thread = SDL_CreateThreadWithProperties(props);
+	SDL_DestroyProperties(props);
+
+	if (!thread) {
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Failed to create %s thread: %s", p_name, SDL_GetError());
+	}
+
+	return thread;
+}
 
 // FUNCTION: ISLE 0x401000
 IsleApp::IsleApp()
@@ -114,10 +175,14 @@ IsleApp::IsleApp()
 	m_cursorBusy = NULL;
 	m_cursorNo = NULL;
 	m_cursorCurrent = NULL;
+	m_verifyThread = NULL;
+	m_loadSavesThread = NULL;
 
 	LegoOmni::CreateInstance();
 
 	m_iniPath = NULL;
+	m_recordPath = NULL;
+	m_replayPath = NULL;
 	m_maxLod = RealtimeView::GetUserMaxLOD();
 	m_maxAllowedExtras = m_islandQuality <= 1 ? 10 : 20;
 }
@@ -149,6 +214,14 @@ IsleApp::~IsleApp()
 	if (m_mediaPath) {
 		delete[] m_mediaPath;
 	}
+
+	if (m_recordPath) {
+		delete[] m_recordPath;
+	}
+
+	if (m_replayPath) {
+		delete[] m_replayPath;
+	}
 }
 
 // FUNCTION: ISLE 0x401260
@@ -157,6 +230,9 @@ void IsleApp::Close()
 	MxDSAction ds;
 	ds.SetUnknown24(-2);
 
+	WaitForVerifyFilesystem();
+	WaitForLoadSaves();
+
 	if (Lego()) {
 		GameState()->Save(0);
 		if (InputManager()) {
@@ -248,19 +324,189 @@ static int isle_update_renderer(void)
 		if (g_closed) {
 			return 0;
 		}
+	}
 
-		if (g_mousedown && g_mousemoved && g_isle) {
-			if (!g_isle->Tick()) {
-				return 1;
+	return 0;
+}
+
+// [library:input]
+// Finger motion is coalesced to the latest position and queued once per
+// frame, right before the tickle in IsleApp::Tick(). The main loop runs
+// several times per frame, so flushing it there would still queue more
+// than one move per frame.
+struct PendingMotion {
+	MxBool m_valid;
+	Uint64 m_timestamp; // First sample since the last flush
+	float m_x;
+	float m_y;
+};
+
+static PendingMotion g_pendingMotion;
+
+static void isle_flush_motion(void)
+{
+	if (!g_pendingMotion.m_valid) {
+		return;
+	}
+
+	g_pendingMotion.m_valid = FALSE;
+
+	float x = SDL_clamp(g_pendingMotion.m_x, 0, 1) * 640;
+	float y = SDL_clamp(g_pendingMotion.m_y, 0, 1) * 480;
+
+	if (InputManager()) {
+		InputManager()->QueueEvent(c_notificationMouseMove, LegoEventNotificationParam::c_lButtonState, x, y, 0);
+	}
+
+	if (g_isle && g_isle->GetDrawCursor()) {
+		VideoManager()->MoveCursor(Min((MxS32) x, 639), Min((MxS32) y, 479));
+	}
+
+	g_profiler.InputSampled(g_pendingMotion.m_timestamp);
+}
+
+static void isle_handle_event(SDL_Event* event)
+{
+	switch (event->type) {
+	case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+	case SDL_EVENT_MOUSE_MOTION:
+	case SDL_EVENT_MOUSE_BUTTON_DOWN:
+	case SDL_EVENT_MOUSE_BUTTON_UP:
+		IDirect3DRMMiniwinDevice* device = GetD3DRMMiniwinDevice();
+		if (device && !device->ConvertEventToRenderCoordinates(event)) {
+			SDL_Log("Failed to convert event coordinates: %s", SDL_GetError());
+		}
+		break;
+	}
+
+	switch (event->type) {
+	case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+		if (!g_closed) {
+			delete g_isle;
+			g_isle = NULL;
+			g_closed = TRUE;
+		}
+		break;
+	case SDL_EVENT_FINGER_MOTION:
+		if (!g_pendingMotion.m_valid) {
+			g_pendingMotion.m_valid = TRUE;
+			g_pendingMotion.m_timestamp = event->tfinger.timestamp;
+		}
+
+		g_pendingMotion.m_x = event->tfinger.x;
+		g_pendingMotion.m_y = event->tfinger.y;
+		break;
+	case SDL_EVENT_FINGER_DOWN: {
+		isle_flush_motion();
+
+		float x = SDL_clamp(event->tfinger.x, 0, 1) * 640;
+		float y = SDL_clamp(event->tfinger.y, 0, 1) * 480;
+
+		if (InputManager()) {
+			InputManager()->QueueEvent(c_notificationButtonDown, LegoEventNotificationParam::c_lButtonState, x, y, 0);
+		}
+
+		g_profiler.InputSampled(event->tfinger.timestamp);
+		break;
+	}
+	case SDL_EVENT_FINGER_UP: {
+		isle_flush_motion();
+
+		float x = SDL_clamp(event->tfinger.x, 0, 1) * 640;
+		float y = SDL_clamp(event->tfinger.y, 0, 1) * 480;
+
+		if (InputManager()) {
+			InputManager()->QueueEvent(c_notificationButtonUp, 0, x, y, 0);
+		}
+
+		g_profiler.InputSampled(event->tfinger.timestamp);
+		break;
+	}
+	default:
+		break;
+	}
+
+	if (event->user.type == g_legoSdlEvents.m_windowsMessage) {
+		switch (event->user.code) {
+		case WM_ISLE_SETCURSOR:
+			break;
+		case WM_TIMER:
+			if (InputManager()) {
+				InputManager()->QueueEvent(c_notificationTimer, (MxU8) (uintptr_t) event->user.data1, 0, 0, 0);
 			}
+			break;
+		default:
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown SDL Windows message: 0x%" SDL_PRIx32, event->user.code);
+			break;
 		}
+	}
+	else if (event->user.type == g_legoSdlEvents.m_presenterProgress) {
+		MxDSAction* action = static_cast<MxDSAction*>(event->user.data1);
+		MxPresenter::TickleState state = static_cast<MxPresenter::TickleState>(event->user.code);
+
+		if (!g_isle->GetGameStarted() && action && state == MxPresenter::e_ready &&
+			!SDL_strncmp(action->GetObjectName(), "Lego_Smk", 8)) {
+			g_isle->SetGameStarted(TRUE);
+			SDL_Log("Game started");
+			LogBootStage("Game started");
+			g_profiler.StartMeasuring();
+		}
+	}
+}
 
-		if (g_mousemoved) {
-			g_mousemoved = FALSE;
+// [library:replay]
+// Input that gets recorded, and fed back from the recording when replaying.
+static MxBool isle_to_replay_event(const SDL_Event* event, IsleReplayEvent& replayEvent)
+{
+	switch (event->type) {
+	case SDL_EVENT_FINGER_DOWN:
+		replayEvent.m_kind = IsleReplayEvent::e_fingerDown;
+		break;
+	case SDL_EVENT_FINGER_UP:
+		replayEvent.m_kind = IsleReplayEvent::e_fingerUp;
+		break;
+	case SDL_EVENT_FINGER_MOTION:
+		replayEvent.m_kind = IsleReplayEvent::e_fingerMotion;
+		break;
+	default:
+		if (event->user.type == g_legoSdlEvents.m_windowsMessage && event->user.code == WM_TIMER) {
+			replayEvent.m_kind = IsleReplayEvent::e_timer;
+			replayEvent.m_code = (MxS32) (uintptr_t) event->user.data1;
+			return TRUE;
 		}
+		return FALSE;
 	}
 
-	return 0;
+	replayEvent.m_code = 0;
+	replayEvent.m_x = event->tfinger.x;
+	replayEvent.m_y = event->tfinger.y;
+	return TRUE;
+}
+
+static void isle_from_replay_event(const IsleReplayEvent& replayEvent, SDL_Event* event)
+{
+	SDL_zerop(event);
+	event->common.timestamp = SDL_GetTicksNS();
+
+	switch (replayEvent.m_kind) {
+	case IsleReplayEvent::e_fingerDown:
+		event->type = SDL_EVENT_FINGER_DOWN;
+		break;
+	case IsleReplayEvent::e_fingerUp:
+		event->type = SDL_EVENT_FINGER_UP;
+		break;
+	case IsleReplayEvent::e_fingerMotion:
+		event->type = SDL_EVENT_FINGER_MOTION;
+		break;
+	case IsleReplayEvent::e_timer:
+		event->user.type = g_legoSdlEvents.m_windowsMessage;
+		event->user.code = WM_TIMER;
+		event->user.data1 = (void*) (uintptr_t) replayEvent.m_code;
+		return;
+	}
+
+	event->tfinger.x = replayEvent.m_x;
+	event->tfinger.y = replayEvent.m_y;
 }
 
 void* isle_init(void* args)
@@ -287,6 +533,8 @@ void* isle_init(void* args)
 	// Original game checks for an existing instance here.
 	// We don't really need that.
 
+	LogBootStage("SDL initialized");
+
 	// Create global app instance
 	g_isle = new IsleApp();
 
@@ -300,94 +548,40 @@ void* isle_init(void* args)
 	}
 
 	while (!g_closed) {
-		while (SDL_PollEvent(event) > 0) {
-			switch (event->type) {
-			case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
-			case SDL_EVENT_MOUSE_MOTION:
-			case SDL_EVENT_MOUSE_BUTTON_DOWN:
-			case SDL_EVENT_MOUSE_BUTTON_UP:
-				IDirect3DRMMiniwinDevice* device = GetD3DRMMiniwinDevice();
-				if (device && !device->ConvertEventToRenderCoordinates(event)) {
-					SDL_Log("Failed to convert event coordinates: %s", SDL_GetError());
-				}
-				break;
-			}
+		Uint64 eventStart = SDL_GetTicksNS();
 
-			switch (event->type) {
-			case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
-				if (!g_closed) {
-					delete g_isle;
-					g_isle = NULL;
-					g_closed = TRUE;
-				}
-				break;
-			case SDL_EVENT_FINGER_MOTION: {
-				g_mousemoved = TRUE;
-
-				float x = SDL_clamp(event->tfinger.x, 0, 1) * 640;
-				float y = SDL_clamp(event->tfinger.y, 0, 1) * 480;
-
-				if (InputManager()) {
-					InputManager()->QueueEvent(c_notificationMouseMove, LegoEventNotificationParam::c_lButtonState, x, y, 0);
-				}
-
-				if (g_isle->GetDrawCursor()) {
-					VideoManager()->MoveCursor(Min((MxS32) x, 639), Min((MxS32) y, 479));
-				}
-				break;
+		if (g_replay.IsReplaying()) {
+			const IsleReplayEvent* replayEvent;
+			while ((replayEvent = g_replay.Next(g_profiler.GetFrameCount()))) {
+				isle_from_replay_event(*replayEvent, event);
+				isle_handle_event(event);
 			}
-			case SDL_EVENT_FINGER_DOWN: {
-				g_mousedown = TRUE;
-
-				float x = SDL_clamp(event->tfinger.x, 0, 1) * 640;
-				float y = SDL_clamp(event->tfinger.y, 0, 1) * 480;
 
-				if (InputManager()) {
-					InputManager()->QueueEvent(c_notificationButtonDown, LegoEventNotificationParam::c_lButtonState, x, y, 0);
-				}
+			if (g_replay.IsFinished() && !g_closed) {
+				ESP_LOGI(TAG, "Replay finished after %" PRIu32 " frames", g_profiler.GetFrameCount());
+				delete g_isle;
+				g_isle = NULL;
+				g_closed = TRUE;
 				break;
 			}
-			case SDL_EVENT_FINGER_UP: {
-				g_mousedown = FALSE;
-
-				float x = SDL_clamp(event->tfinger.x, 0, 1) * 640;
-				float y = SDL_clamp(event->tfinger.y, 0, 1) * 480;
+		}
 
-				if (InputManager()) {
-					InputManager()->QueueEvent(c_notificationButtonUp, 0, x, y, 0);
+		while (SDL_PollEvent(event) > 0) {
+			IsleReplayEvent replayEvent;
+			if (isle_to_replay_event(event, replayEvent)) {
+				// The recording is the only source of input while replaying
+				if (g_replay.IsReplaying()) {
+					continue;
 				}
-				break;
-			}
-			default:
-				break;
-			}
 
-			if (event->user.type == g_legoSdlEvents.m_windowsMessage) {
-				switch (event->user.code) {
-				case WM_ISLE_SETCURSOR:
-					break;
-				case WM_TIMER:
-					if (InputManager()) {
-						InputManager()->QueueEvent(c_notificationTimer, (MxU8) (uintptr_t) event->user.data1, 0, 0, 0);
-					}
-					break;
-				default:
-					SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown SDL Windows message: 0x%" SDL_PRIx32, event->user.code);
-					break;
-				}
-			}
-			else if (event->user.type == g_legoSdlEvents.m_presenterProgress) {
-				MxDSAction* action = static_cast<MxDSAction*>(event->user.data1);
-				MxPresenter::TickleState state = static_cast<MxPresenter::TickleState>(event->user.code);
-
-				if (!g_isle->GetGameStarted() && action && state == MxPresenter::e_ready &&
-					!SDL_strncmp(action->GetObjectName(), "Lego_Smk", 8)) {
-					g_isle->SetGameStarted(TRUE);
-					SDL_Log("Game started");
-				}
+				g_replay.Record(g_profiler.GetFrameCount(), replayEvent);
 			}
+
+			isle_handle_event(event);
 		}
 
+		g_profiler.AddTime(IsleProfiler::e_events, SDL_GetTicksNS() - eventStart);
+
 		ret = isle_update_renderer();
 		if (ret) {
 			ESP_LOGE(TAG, "%s\n%s",
@@ -403,6 +597,9 @@ void* isle_init(void* args)
 	}
 
 exit:
+	g_replay.Stop(g_profiler.GetFrameCount());
+	g_profiler.Report();
+
 	if (window)
 		SDL_DestroyWindow(window);
 
@@ -433,6 +630,12 @@ MxResult IsleApp::SetupWindow()
 	if (!LoadConfig()) {
 		return FAILURE;
 	}
+	LogBootStage("Config loaded");
+
+	// [library:startup]
+	// Checking the game files only needs the search paths, so do it on a
+	// worker thread while the window and LEGO Omni are being set up.
+	m_verifyThread = CreateBootThread(VerifyFilesystemThread, "isle_verify", this);
 
 	SetupVideoFlags(
 		m_fullScreen,
@@ -448,7 +651,16 @@ MxResult IsleApp::SetupWindow()
 
 	MxOmni::SetSound3D(m_use3dSound);
 
-	srand(time(NULL));
+	// [library:replay]
+	// A replay needs the same random sequence as the recorded session.
+	if (m_replayPath) {
+		g_replay.StartReplay(m_replayPath);
+	}
+	else if (m_recordPath) {
+		g_replay.StartRecording(m_recordPath);
+	}
+
+	srand(g_replay.GetSeed());
 
 	// [library:window] Use original game cursors in the resources instead?
 	m_cursorCurrent = m_cursorArrow = SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_DEFAULT);
@@ -475,20 +687,44 @@ MxResult IsleApp::SetupWindow()
 
 	SDL_DestroyProperties(props);
 
-	if (!m_windowHandle)
+	if (!m_windowHandle) {
+		WaitForVerifyFilesystem();
 		return FAILURE;
+	}
 
-	if (!SetupLegoOmni())
+	if (!SetupLegoOmni()) {
+		WaitForVerifyFilesystem();
 		return FAILURE;
+	}
+	LogBootStage("LEGO Omni created");
+
+	// [library:replay]
+	// Recording and replaying both start without save data and never touch
+	// the real saves, otherwise each run would load what the previous one wrote.
+	if (g_replay.GetMode() != IsleReplay::e_off) {
+		static char replaySavePath[] = REPLAY_SAVE_PATH;
+		ResetReplaySavePath(replaySavePath);
+		GameState()->SetSavePath(replaySavePath);
+	}
+	else {
+		GameState()->SetSavePath(m_savePath);
+	}
 
-	GameState()->SetSavePath(m_savePath);
-
-	if (VerifyFilesystem() != SUCCESS) {
+	MxResult verified = m_verifyThread ? WaitForVerifyFilesystem() : VerifyFilesystem();
+	if (verified != SUCCESS) {
 		return FAILURE;
 	}
 
-	GameState()->SerializePlayersInfo(LegoStorage::c_read);
-	GameState()->SerializeScoreHistory(LegoStorage::c_read);
+	// [library:startup]
+	// Load the saves while the rest of the window and presenter setup runs.
+	// The thread writes GameState (players and score history) unguarded, so
+	// nothing may read GameState until it is joined: Tick() waits for it
+	// before the first tickle, since that is what dispatches queued input
+	// and runs the game code.
+	m_loadSavesThread = CreateBootThread(LoadSavesThread, "isle_saves", this);
+	if (!m_loadSavesThread) {
+		LoadSavesThread(this);
+	}
 
 	MxS32 iVar10;
 	switch (m_islandQuality) {
@@ -595,6 +831,7 @@ bool IsleApp::LoadConfig()
 		iniparser_set(dict, "isle:Draw Cursor", m_drawCursor ? "true" : "false");
 
 		iniparser_set(dict, "isle:Back Buffers in Video RAM", "-1");
+		iniparser_set(dict, "isle:Display Bit Depth", m_using8bit ? "8" : "16");
 
 		iniparser_set(dict, "isle:Island Quality", SDL_itoa(m_islandQuality, buf, 10));
 		iniparser_set(dict, "isle:Island Texture", SDL_itoa(m_islandTexture, buf, 10));
@@ -638,7 +875,12 @@ bool IsleApp::LoadConfig()
 	MxS32 bitDepth = iniparser_getint(dict, "isle:Display Bit Depth", -1);
 	if (bitDepth != -1) {
 		if (bitDepth == 8) {
-			m_using8bit = TRUE;
+			// [library:config]
+			// The miniwin backend and the panel scanout on this port only
+			// handle 16-bit surfaces, there is no indexed render path yet.
+			ESP_LOGW(TAG, "Display Bit Depth 8 is not supported yet, using 16");
+			m_using8bit = FALSE;
+			m_using16bit = TRUE;
 		}
 		else if (bitDepth == 16) {
 			m_using16bit = TRUE;
@@ -650,6 +892,18 @@ bool IsleApp::LoadConfig()
 	m_maxLod = iniparser_getdouble(dict, "isle:Max LOD", m_maxLod);
 	m_maxAllowedExtras = iniparser_getint(dict, "isle:Max Allowed Extras", m_maxAllowedExtras);
 
+	const char* recordPath = iniparser_getstring(dict, "isle:Input Record", NULL);
+	if (recordPath != NULL) {
+		m_recordPath = new char[strlen(recordPath) + 1];
+		strcpy(m_recordPath, recordPath);
+	}
+
+	const char* replayPath = iniparser_getstring(dict, "isle:Input Replay", NULL);
+	if (replayPath != NULL) {
+		m_replayPath = new char[strlen(replayPath) + 1];
+		strcpy(m_replayPath, replayPath);
+	}
+
 	const char* deviceId = iniparser_getstring(dict, "isle:3D Device ID", NULL);
 	if (deviceId != NULL) {
 		m_deviceId = new char[strlen(deviceId) + 1];
@@ -675,8 +929,16 @@ inline bool IsleApp::Tick()
 	// GLOBAL: ISLE 0x4101c0
 	static MxLong g_lastFrameTime = 0;
 
-	// GLOBAL: ISLE 0x4101bc
-	static MxS32 g_startupDelay = 200;
+	// [library:startup]
+	// The original game counts down 200 frames (about 2 s at m_frameDelta = 10)
+	// before starting the first action. Count wall-clock time from the first
+	// frame instead, so the time spent opening ISLE.SI comes out of the delay
+	// rather than being added to it.
+	static Uint64 g_startupDeadline = 0;
+	static MxBool g_startupDone = FALSE;
+
+	static MxStreamController* g_startupStream = NULL;
+	static MxBool g_startupNoCD = FALSE;
 
 	if (!m_windowActive) {
 		SDL_Delay(1);
@@ -703,36 +965,68 @@ inline bool IsleApp::Tick()
 		return true;
 	}
 
-	if (!Lego()->IsPaused()) {
+	WaitForLoadSaves();
+	isle_flush_motion();
+
+	MxBool tickled = !Lego()->IsPaused();
+	if (tickled) {
+		Uint64 tickleStart = SDL_GetTicksNS();
 		TickleManager()->Tickle();
+
+		Uint64 tickleTime = SDL_GetTicksNS() - tickleStart;
+		g_profiler.AddTime(IsleProfiler::e_tickle, tickleTime);
+
+		// World loads (LegoWorldPresenter and friends) run inside a single
+		// tickle and block the display, so make them visible in the logs.
+		if (tickleTime >= SDL_MS_TO_NS(TICKLE_STALL_MS)) {
+			ESP_LOGW(TAG, "Tickle stalled for %" PRIu64 " ms", SDL_NS_TO_MS(tickleTime));
+		}
 	}
 	g_lastFrameTime = currentTime;
+	g_profiler.EndFrame(tickled);
 
-	if (g_startupDelay == 0) {
+	if (g_startupDone) {
 		return true;
 	}
 
-	g_startupDelay--;
-	if (g_startupDelay != 0) {
+	// [library:startup]
+	// The original game opens ISLE.SI once the startup delay is over. Open it
+	// on the first tick instead; the deadline is already running, so the time
+	// spent reading its header and offset table from the SD card is not
+	// added to the delay.
+	if (!g_startupStream) {
+		g_startupDeadline = SDL_GetTicks() + STARTUP_DELAY_MS;
+
+		g_startupStream = Streamer()->Open("\\lego\\scripts\\isle\\isle", MxStreamer::e_diskStream);
+
+		if (!g_startupStream) {
+			g_startupStream = Streamer()->Open("\\lego\\scripts\\nocd", MxStreamer::e_diskStream);
+			if (!g_startupStream) {
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open NOCD.si: Streamer failed to load");
+				return false;
+			}
+
+			g_startupNoCD = TRUE;
+		}
+
+		LogBootStage(g_startupNoCD ? "NOCD.SI opened" : "ISLE.SI opened");
+	}
+
+	if (SDL_GetTicks() < g_startupDeadline) {
 		return true;
 	}
 
+	g_startupDone = TRUE;
+
 	LegoOmni::GetInstance()->CreateBackgroundAudio();
 	BackgroundAudioManager()->Enable(m_useMusic);
 
-	MxStreamController* stream = Streamer()->Open("\\lego\\scripts\\isle\\isle", MxStreamer::e_diskStream);
 	MxDSAction ds;
+	ds.SetAtomId(g_startupStream->GetAtom());
+	ds.SetUnknown24(-1);
+	ds.SetObjectId(0);
 
-	if (!stream) {
-		stream = Streamer()->Open("\\lego\\scripts\\nocd", MxStreamer::e_diskStream);
-		if (!stream) {
-			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open NOCD.si: Streamer failed to load");
-			return false;
-		}
-
-		ds.SetAtomId(stream->GetAtom());
-		ds.SetUnknown24(-1);
-		ds.SetObjectId(0);
+	if (g_startupNoCD) {
 		VideoManager()->EnableFullScreenMovie(TRUE, TRUE);
 
 		if (Start(&ds) != SUCCESS) {
@@ -741,32 +1035,36 @@ inline bool IsleApp::Tick()
 		}
 	}
 	else {
-		ds.SetAtomId(stream->GetAtom());
-		ds.SetUnknown24(-1);
-		ds.SetObjectId(0);
 		if (Start(&ds) != SUCCESS) {
 			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open ISLE.si: Failed to start initial action");
 			return false;
 		}
 	}
 
+	LogBootStage("Initial action started");
 	return true;
 }
 
 MxResult IsleApp::VerifyFilesystem()
 {
+	const char* searchPaths[MAX_SEARCH_PATHS] = {".", m_hdPath, m_cdPath};
+	g_fileIndex.Build(searchPaths, MAX_SEARCH_PATHS);
+
 	for (const char* file : g_files) {
-		const char* searchPaths[] = {".", m_hdPath, m_cdPath};
-		bool found = false;
+		bool found = g_fileIndex.Find(file);
 
-		for (const char* base : searchPaths) {
-			MxString path(base);
-			path += file;
-			path.MapPathToFilesystem();
+		// Fall back to probing each search path, in case the index could
+		// not be built (e.g. directory enumeration failed).
+		if (!found) {
+			for (const char* base : searchPaths) {
+				MxString path(base);
+				path += file;
+				path.MapPathToFilesystem();
 
-			if (SDL_GetPathInfo(path.GetData(), NULL)) {
-				found = true;
-				break;
+				if (SDL_GetPathInfo(path.GetData(), NULL)) {
+					found = true;
+					break;
+				}
 			}
 		}
 
@@ -782,13 +1080,38 @@ MxResult IsleApp::VerifyFilesystem()
 			);
 
 			ESP_LOGE(TAG, "LEGO® Island Error\n%s", buffer);
+			g_fileIndex.Clear();
 			return FAILURE;
 		}
 	}
 
+	// Nothing needs the index after the check
+	g_fileIndex.Clear();
 	return SUCCESS;
 }
 
+// Returns the result of the background filesystem check, or SUCCESS if there
+// is none running.
+MxResult IsleApp::WaitForVerifyFilesystem()
+{
+	if (!m_verifyThread) {
+		return SUCCESS;
+	}
+
+	int result;
+	SDL_WaitThread(m_verifyThread, &result);
+	m_verifyThread = NULL;
+	return result;
+}
+
+void IsleApp::WaitForLoadSaves()
+{
+	if (m_loadSavesThread) {
+		SDL_WaitThread(m_loadSavesThread, NULL);
+		m_loadSavesThread = NULL;
+	}
+}
+
 IDirect3DRMMiniwinDevice* GetD3DRMMiniwinDevice()
 {
 	LegoVideoManager* videoManager = LegoOmni::GetInstance()->GetVideoManager();
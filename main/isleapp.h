@@ -53,6 +53,8 @@ public:
 
 	MxResult ParseArguments(int argc, char** argv);
 	MxResult VerifyFilesystem();
+	MxResult WaitForVerifyFilesystem();
+	void WaitForLoadSaves();
 
 private:
 	char* m_hdPath;              // 0x00
@@ -85,8 +87,13 @@ private:
 	char* m_mediaPath;
 
 	char* m_iniPath;
+	char* m_recordPath;
+	char* m_replayPath;
 	MxFloat m_maxLod;
 	MxU32 m_maxAllowedExtras;
+
+	SDL_Thread* m_verifyThread;
+	SDL_Thread* m_loadSavesThread;
 };
 
 extern IsleApp* g_isle;
@@ -106,6 +113,8 @@ extern "C"
  */
 #define DATA_PATH BSP_SD_MOUNT_POINT "/"
 #define CFG_PATH BSP_SD_MOUNT_POINT "/cfgpath/"
+/* Scratch save path used while recording or replaying input */
+#define REPLAY_SAVE_PATH CFG_PATH "replay/"
 
 void* isle_init(void* args);
 #ifdef __cplusplus
@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "isleassets.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+#include "esp_partition.h"
+#else
+/*
+ * Host stand-in: map a file produced by tools/mkassets.py instead of the
+ * flash partition, so the lookup path can be exercised off-device.
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ESP_LOGI(tag, fmt, ...) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#endif
+
+static const char *TAG = "isleassets";
+
+static const uint8_t *s_image;
+static size_t s_image_size;
+static const struct isle_assets_entry *s_entries;
+static uint32_t s_count;
+
+/*
+ * isle_assets_open() finds the backing storage and returns its size (0 if
+ * there is none), isle_assets_map() then maps its first size bytes.
+ * isle_assets_close() releases what isle_assets_open() found.
+ */
+#ifdef ESP_PLATFORM
+static const esp_partition_t *s_partition;
+static esp_partition_mmap_handle_t s_mmap_handle;
+
+static size_t isle_assets_open(void)
+{
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ISLE_ASSETS_PARTITION_SUBTYPE,
+                                           ISLE_ASSETS_PARTITION_LABEL);
+    return s_partition ? s_partition->size : 0;
+}
+
+static const void *isle_assets_map(size_t size)
+{
+    const void *ptr;
+    esp_err_t eret;
+
+    eret = esp_partition_mmap(s_partition, 0, size, ESP_PARTITION_MMAP_DATA, &ptr, &s_mmap_handle);
+    if (eret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to map asset partition: %s", esp_err_to_name(eret));
+        return NULL;
+    }
+
+    return ptr;
+}
+
+static void isle_assets_unmap(const void *ptr, size_t size)
+{
+    esp_partition_munmap(s_mmap_handle);
+}
+
+static void isle_assets_close(void)
+{
+    s_partition = NULL;
+}
+#else
+static int s_fd = -1;
+
+static size_t isle_assets_open(void)
+{
+    const char *path = getenv("ISLE_ASSETS_IMAGE");
+    struct stat st;
+
+    if (!path) {
+        return 0;
+    }
+
+    s_fd = open(path, O_RDONLY);
+    if (s_fd < 0) {
+        return 0;
+    }
+
+    if (fstat(s_fd, &st) < 0) {
+        close(s_fd);
+        s_fd = -1;
+        return 0;
+    }
+
+    return st.st_size;
+}
+
+static const void *isle_assets_map(size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, s_fd, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static void isle_assets_unmap(const void *ptr, size_t size)
+{
+    munmap((void *)ptr, size);
+}
+
+static void isle_assets_close(void)
+{
+    if (s_fd >= 0) {
+        close(s_fd);
+        s_fd = -1;
+    }
+}
+#endif
+
+/*
+ * Only the header is mapped to validate the image, so a blank or small
+ * image doesn't take up more MMU pages than it needs.
+ */
+static int isle_assets_read_header(size_t available, struct isle_assets_header *hdr)
+{
+    const void *ptr;
+
+    if (available < sizeof(*hdr)) {
+        return -1;
+    }
+
+    ptr = isle_assets_map(sizeof(*hdr));
+    if (!ptr) {
+        return -1;
+    }
+
+    memcpy(hdr, ptr, sizeof(*hdr));
+    isle_assets_unmap(ptr, sizeof(*hdr));
+
+    if (hdr->magic == 0xffffffff) {
+        ESP_LOGI(TAG, "Asset partition is empty, reading everything from the SD card");
+        return -1;
+    }
+
+    if (hdr->magic != ISLE_ASSETS_MAGIC || hdr->version != ISLE_ASSETS_VERSION || hdr->size < sizeof(*hdr) ||
+        hdr->size > available ||
+        hdr->count > (hdr->size - sizeof(*hdr)) / sizeof(struct isle_assets_entry)) {
+        ESP_LOGW(TAG, "Asset partition doesn't hold a valid image, ignoring it");
+        return -1;
+    }
+
+    return 0;
+}
+
+int isle_assets_mount(void)
+{
+    struct isle_assets_header hdr;
+    size_t available;
+    uint32_t i;
+
+    available = isle_assets_open();
+    if (!available) {
+        ESP_LOGI(TAG, "No asset partition, reading everything from the SD card");
+        return -1;
+    }
+
+    if (isle_assets_read_header(available, &hdr) < 0) {
+        goto fail;
+    }
+
+    s_image = isle_assets_map(hdr.size);
+    if (!s_image) {
+        goto fail;
+    }
+    s_image_size = hdr.size;
+
+    s_entries = (const struct isle_assets_entry *)(s_image + sizeof(hdr));
+    for (i = 0; i < hdr.count; i++) {
+        if (s_entries[i].offset > hdr.size || s_entries[i].size > hdr.size - s_entries[i].offset) {
+            ESP_LOGW(TAG, "Asset %.*s is out of bounds, ignoring the image", ISLE_ASSETS_PATH_MAX,
+                     s_entries[i].path);
+            goto fail;
+        }
+    }
+
+    s_count = hdr.count;
+    ESP_LOGI(TAG, "Mapped %" PRIu32 " assets (%" PRIu32 " bytes)", s_count, hdr.size);
+    return 0;
+
+fail:
+    isle_assets_unmount();
+    return -1;
+}
+
+void isle_assets_unmount(void)
+{
+    if (s_image) {
+        isle_assets_unmap(s_image, s_image_size);
+    }
+
+    isle_assets_close();
+
+    s_image = NULL;
+    s_image_size = 0;
+    s_entries = NULL;
+    s_count = 0;
+}
+
+static int isle_assets_path_equal(const char *a, const char *b)
+{
+    size_t n;
+
+    for (n = 0; n < ISLE_ASSETS_PATH_MAX; n++, a++, b++) {
+        char ca = *a == '\\' ? '/' : tolower((unsigned char)*a);
+        char cb = *b == '\\' ? '/' : tolower((unsigned char)*b);
+
+        if (ca != cb) {
+            return 0;
+        }
+        if (!ca) {
+            return 1;
+        }
+    }
+
+    /* Entry paths fill the whole field without a terminator */
+    return !*b;
+}
+
+const void *isle_assets_find(const char *path, size_t *size)
+{
+    uint32_t i;
+
+    for (i = 0; i < s_count; i++) {
+        if (isle_assets_path_equal(s_entries[i].path, path)) {
+            if (size) {
+                *size = s_entries[i].size;
+            }
+            return s_image + s_entries[i].offset;
+        }
+    }
+
+    return NULL;
+}
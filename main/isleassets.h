@@ -0,0 +1,57 @@
+#ifndef ISLEASSETS_H
+#define ISLEASSETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Read-only asset image stored in the "assets" flash partition, built on
+ * the host with tools/mkassets.py. The partition is memory-mapped into
+ * the flash cache address space, so lookups hand out pointers straight
+ * into flash without copying anything or touching the SD card.
+ */
+#define ISLE_ASSETS_PARTITION_LABEL "assets"
+#define ISLE_ASSETS_PARTITION_SUBTYPE 0x40
+
+#define ISLE_ASSETS_MAGIC 0x414c5349 /* "ISLA" */
+#define ISLE_ASSETS_VERSION 1
+#define ISLE_ASSETS_PATH_MAX 64
+
+struct isle_assets_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t size; /* Total image size, including this header */
+};
+
+struct isle_assets_entry {
+    char path[ISLE_ASSETS_PATH_MAX]; /* e.g. "/LEGO/data/WORLD.WDB" */
+    uint32_t offset; /* From the start of the image */
+    uint32_t size;
+};
+
+/*
+ * Maps the asset image. Returns 0 on success, or a negative value if the
+ * partition is missing or doesn't hold a valid image, which is not fatal;
+ * everything keeps coming from the SD card in that case.
+ */
+int isle_assets_mount(void);
+void isle_assets_unmount(void);
+
+/*
+ * Looks up an asset by path. Matching is case-insensitive and treats '\\'
+ * and '/' the same, so both game-style and filesystem-style paths work.
+ * Returns a pointer to the mapped data, or NULL if not found.
+ */
+const void *isle_assets_find(const char *path, size_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ISLEASSETS_H
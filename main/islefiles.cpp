@@ -1,4 +1,13 @@
-const char* g_files[46] = {
+#include "islefiles.h"
+
+#include "mxstring.h"
+
+#include <SDL3/SDL.h>
+
+// All entries in g_files live below this directory
+#define GAME_ROOT "/LEGO/"
+
+const char* g_files[NUM_GAME_FILES] = {
 	"/LEGO/Scripts/CREDITS.SI",
 	"/LEGO/Scripts/INTRO.SI",
 	"/LEGO/Scripts/NOCD.SI",
@@ -46,3 +55,73 @@ const char* g_files[46] = {
 	"/LEGO/data/WORLD.WDB",
 	"/LEGO/data/testinf.dta",
 };
+
+IsleFileIndex g_fileIndex;
+
+IsleFileIndex::IsleFileIndex()
+{
+	m_numSearchPaths = 0;
+}
+
+IsleFileIndex::~IsleFileIndex()
+{
+	Clear();
+}
+
+void IsleFileIndex::Build(const char* const* p_searchPaths, MxS32 p_count)
+{
+	Clear();
+
+	for (MxS32 i = 0; i < p_count && m_numSearchPaths < MAX_SEARCH_PATHS; i++) {
+		if (!p_searchPaths[i]) {
+			continue;
+		}
+
+		MxString root(p_searchPaths[i]);
+		root += GAME_ROOT;
+		root.MapPathToFilesystem();
+
+		int count = 0;
+		char** entries = SDL_GlobDirectory(root.GetData(), NULL, SDL_GLOB_CASEINSENSITIVE, &count);
+		if (!entries) {
+			continue;
+		}
+
+		SearchPath& searchPath = m_searchPaths[m_numSearchPaths++];
+		searchPath.m_entries = entries;
+		searchPath.m_count = count;
+	}
+}
+
+// p_file is a game path such as "/LEGO/data/WORLD.WDB"
+MxBool IsleFileIndex::Find(const char* p_file)
+{
+	if (SDL_strncasecmp(p_file, GAME_ROOT, SDL_strlen(GAME_ROOT))) {
+		return FALSE;
+	}
+
+	const char* relative = p_file + SDL_strlen(GAME_ROOT);
+
+	for (MxS32 i = 0; i < m_numSearchPaths; i++) {
+		SearchPath& searchPath = m_searchPaths[i];
+
+		for (int j = 0; j < searchPath.m_count; j++) {
+			if (!SDL_strcasecmp(searchPath.m_entries[j], relative)) {
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+void IsleFileIndex::Clear()
+{
+	for (MxS32 i = 0; i < m_numSearchPaths; i++) {
+		SDL_free(m_searchPaths[i].m_entries);
+		m_searchPaths[i].m_entries = NULL;
+		m_searchPaths[i].m_count = 0;
+	}
+
+	m_numSearchPaths = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef ISLEFILES_H
+#define ISLEFILES_H
+
+#include "mxtypes.h"
+
+#define NUM_GAME_FILES 46
+#define MAX_SEARCH_PATHS 3
+
+extern const char* g_files[NUM_GAME_FILES];
+
+// [library:filesystem]
+// Case-insensitive index of the game's LEGO directory, used for the file
+// check at boot. Enumerating each search path once is much cheaper than
+// probing every game file in every search path on a no-LFN FAT volume.
+class IsleFileIndex {
+public:
+	IsleFileIndex();
+	~IsleFileIndex();
+
+	void Build(const char* const* p_searchPaths, MxS32 p_count);
+	MxBool Find(const char* p_file);
+	void Clear();
+
+private:
+	struct SearchPath {
+		char** m_entries;
+		int m_count;
+	};
+
+	SearchPath m_searchPaths[MAX_SEARCH_PATHS];
+	MxS32 m_numSearchPaths;
+};
+
+extern IsleFileIndex g_fileIndex;
+
+#endif // ISLEFILES_H
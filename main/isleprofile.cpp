@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include "isleprofile.h"
+
+static const char* TAG = "isleprofile";
+
+static const char* g_sectionNames[IsleProfiler::e_numSections] = {
+	"events",
+	"tickle",
+};
+
+IsleProfiler g_profiler;
+
+IsleProfiler::IsleProfiler()
+{
+	m_measuring = FALSE;
+	m_frameCount = 0;
+	m_frameTime = 0;
+	m_inputTimestamp = 0;
+	ResetStatistics();
+}
+
+void IsleProfiler::ResetStatistics()
+{
+	SDL_zeroa(m_histogram);
+	SDL_zeroa(m_sectionTime);
+	m_maxFrameTime = 0;
+	m_measuredFrames = 0;
+	m_inputLatency = 0;
+	m_maxInputLatency = 0;
+	m_inputCount = 0;
+}
+
+// Frames before this (the startup delay, loading the intro) are not part of
+// the statistics, they would only add noise to the comparison.
+void IsleProfiler::StartMeasuring()
+{
+	ResetStatistics();
+	m_measuring = TRUE;
+}
+
+void IsleProfiler::AddTime(Section p_section, Uint64 p_ns)
+{
+	if (m_measuring) {
+		m_sectionTime[p_section] += p_ns;
+	}
+
+	m_frameTime += p_ns;
+}
+
+// p_timestamp is the SDL event timestamp of input that was just handed to the
+// game. Its latency is measured up to the end of the frame that handles it.
+void IsleProfiler::InputSampled(Uint64 p_timestamp)
+{
+	if (!m_inputTimestamp || p_timestamp < m_inputTimestamp) {
+		m_inputTimestamp = p_timestamp;
+	}
+}
+
+// A frame is all the work done since the previous frame, not including the
+// time spent waiting for the next one to be due. p_tickled is FALSE if the
+// game was paused and nothing ran, pending input is then still unshown.
+void IsleProfiler::EndFrame(MxBool p_tickled)
+{
+	m_frameCount++;
+
+	if (m_measuring) {
+		Uint64 bucket = SDL_NS_TO_US(m_frameTime) / PROFILE_BUCKET_US;
+		m_histogram[SDL_min(bucket, PROFILE_HISTOGRAM_BUCKETS - 1)]++;
+		m_maxFrameTime = SDL_max(m_maxFrameTime, m_frameTime);
+		m_measuredFrames++;
+	}
+
+	m_frameTime = 0;
+
+	if (m_inputTimestamp && p_tickled) {
+		if (m_measuring) {
+			Uint64 latency = SDL_GetTicksNS() - m_inputTimestamp;
+			m_inputLatency += latency;
+			m_maxInputLatency = SDL_max(m_maxInputLatency, latency);
+			m_inputCount++;
+		}
+
+		m_inputTimestamp = 0;
+	}
+}
+
+// Upper bound in us of the bucket holding the given percentile
+MxU32 IsleProfiler::Percentile(MxU32 p_percent)
+{
+	Uint64 target = ((Uint64) m_measuredFrames * p_percent + 99) / 100;
+	Uint64 count = 0;
+
+	for (MxU32 i = 0; i < PROFILE_HISTOGRAM_BUCKETS; i++) {
+		count += m_histogram[i];
+		if (count >= target) {
+			return (i + 1) * PROFILE_BUCKET_US;
+		}
+	}
+
+	return PROFILE_HISTOGRAM_BUCKETS * PROFILE_BUCKET_US;
+}
+
+void IsleProfiler::Report()
+{
+	if (!m_measuredFrames) {
+		return;
+	}
+
+	MxU32 p50 = Percentile(50);
+	MxU32 p95 = Percentile(95);
+	MxU32 p99 = Percentile(99);
+	Uint64 max = SDL_NS_TO_US(m_maxFrameTime);
+
+	ESP_LOGI(
+		TAG,
+		"%" PRIu32 " frames: p50 <%" PRIu32 " us, p95 <%" PRIu32 " us, p99 <%" PRIu32 " us, max %" PRIu64 " us",
+		m_measuredFrames,
+		p50,
+		p95,
+		p99,
+		max
+	);
+
+	for (MxU32 i = 0; i < e_numSections; i++) {
+		ESP_LOGI(
+			TAG,
+			"  %-8s %" PRIu64 " us/frame",
+			g_sectionNames[i],
+			SDL_NS_TO_US(m_sectionTime[i]) / m_measuredFrames
+		);
+	}
+
+	if (m_inputCount) {
+		ESP_LOGI(
+			TAG,
+			"Input latency: avg %" PRIu64 " us, max %" PRIu64 " us over %" PRIu32 " frames",
+			SDL_NS_TO_US(m_inputLatency) / m_inputCount,
+			SDL_NS_TO_US(m_maxInputLatency),
+			m_inputCount
+		);
+	}
+
+	size_t total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
+	size_t minFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+	ESP_LOGI(TAG, "Peak heap usage: %u of %u bytes", (unsigned) (total - minFree), (unsigned) total);
+
+	// Machine-readable copy of the above for tools/benchcmp.py. Every metric
+	// is "lower is better".
+	char json[384];
+	int len = SDL_snprintf(
+		json,
+		sizeof(json),
+		"{\"frames\": %" PRIu32 ", \"p50_us\": %" PRIu32 ", \"p95_us\": %" PRIu32 ", \"p99_us\": %" PRIu32
+		", \"max_us\": %" PRIu64 ", \"peak_heap\": %u",
+		m_measuredFrames,
+		p50,
+		p95,
+		p99,
+		max,
+		(unsigned) (total - minFree)
+	);
+
+	for (MxU32 i = 0; i < e_numSections && len < (int) sizeof(json); i++) {
+		len += SDL_snprintf(
+			json + len,
+			sizeof(json) - len,
+			", \"%s_us\": %" PRIu64,
+			g_sectionNames[i],
+			SDL_NS_TO_US(m_sectionTime[i]) / m_measuredFrames
+		);
+	}
+
+	if (m_inputCount && len < (int) sizeof(json)) {
+		len += SDL_snprintf(
+			json + len,
+			sizeof(json) - len,
+			", \"input_latency_us\": %" PRIu64 ", \"max_input_latency_us\": %" PRIu64,
+			SDL_NS_TO_US(m_inputLatency) / m_inputCount,
+			SDL_NS_TO_US(m_maxInputLatency)
+		);
+	}
+
+	if (len < (int) sizeof(json)) {
+		SDL_snprintf(json + len, sizeof(json) - len, "}");
+	}
+
+	ESP_LOGI(TAG, "BENCH %s", json);
+}
@@ -0,0 +1,55 @@
+#ifndef ISLEPROFILE_H
+#define ISLEPROFILE_H
+
+#include "mxtypes.h"
+
+#include <SDL3/SDL.h>
+
+// Frame times are bucketed in steps of PROFILE_BUCKET_US, the last bucket
+// catches the rest.
+#define PROFILE_BUCKET_US 100
+#define PROFILE_HISTOGRAM_BUCKETS 1024
+
+// [library:profile]
+// Frame-time statistics for comparing builds, see IsleProfiler::Report().
+class IsleProfiler {
+public:
+	enum Section {
+		e_events,
+		e_tickle,
+		e_numSections
+	};
+
+	IsleProfiler();
+
+	void StartMeasuring();
+	void AddTime(Section p_section, Uint64 p_ns);
+	void InputSampled(Uint64 p_timestamp);
+	void EndFrame(MxBool p_tickled);
+	void Report();
+
+	// Counts every frame since boot, measured or not
+	MxU32 GetFrameCount() { return m_frameCount; }
+
+private:
+	void ResetStatistics();
+	MxU32 Percentile(MxU32 p_percent);
+
+	MxBool m_measuring;
+	MxU32 m_frameCount;
+	Uint64 m_frameTime;
+
+	MxU32 m_histogram[PROFILE_HISTOGRAM_BUCKETS];
+	Uint64 m_sectionTime[e_numSections];
+	Uint64 m_maxFrameTime;
+	MxU32 m_measuredFrames;
+
+	Uint64 m_inputTimestamp; // Oldest input not yet shown, 0 if none
+	Uint64 m_inputLatency;
+	Uint64 m_maxInputLatency;
+	MxU32 m_inputCount;
+};
+
+extern IsleProfiler g_profiler;
+
+#endif // ISLEPROFILE_H
@@ -0,0 +1,189 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+
+#include "esp_log.h"
+
+#include "islereplay.h"
+
+#include <time.h>
+
+static const char* TAG = "islereplay";
+
+#define REPLAY_MAGIC 0x50525349 // "ISRP"
+#define REPLAY_VERSION 1
+
+// Initial size of the in-memory recording, grown by doubling
+#define REPLAY_RECORD_CAPACITY 1024
+
+struct IsleReplayHeader {
+	MxU32 m_magic;
+	MxU32 m_version;
+	MxU32 m_seed;
+};
+
+IsleReplay g_replay;
+
+IsleReplay::IsleReplay()
+{
+	m_mode = e_off;
+	m_seed = time(NULL);
+	m_file = NULL;
+	m_data = NULL;
+	m_events = NULL;
+	m_numEvents = 0;
+	m_nextEvent = 0;
+	m_recorded = NULL;
+	m_numRecorded = 0;
+	m_recordCapacity = 0;
+	m_finished = FALSE;
+}
+
+IsleReplay::~IsleReplay()
+{
+	if (m_file) {
+		SDL_CloseIO(m_file);
+	}
+
+	SDL_free(m_data);
+	SDL_free(m_recorded);
+}
+
+MxBool IsleReplay::StartRecording(const char* p_path)
+{
+	m_file = SDL_IOFromFile(p_path, "wb");
+	if (!m_file) {
+		ESP_LOGE(TAG, "Failed to create input recording '%s': %s", p_path, SDL_GetError());
+		return FALSE;
+	}
+
+	IsleReplayHeader header = {REPLAY_MAGIC, REPLAY_VERSION, m_seed};
+	if (SDL_WriteIO(m_file, &header, sizeof(header)) != sizeof(header)) {
+		ESP_LOGE(TAG, "Failed to write input recording '%s': %s", p_path, SDL_GetError());
+		SDL_CloseIO(m_file);
+		m_file = NULL;
+		return FALSE;
+	}
+
+	ESP_LOGI(TAG, "Recording input to '%s' (seed %" PRIu32 ")", p_path, m_seed);
+	m_mode = e_record;
+	return TRUE;
+}
+
+MxBool IsleReplay::StartReplay(const char* p_path)
+{
+	size_t size;
+	MxU8* data = (MxU8*) SDL_LoadFile(p_path, &size);
+	if (!data) {
+		ESP_LOGE(TAG, "Failed to load input recording '%s': %s", p_path, SDL_GetError());
+		return FALSE;
+	}
+
+	IsleReplayHeader* header = (IsleReplayHeader*) data;
+	if (size < sizeof(*header) || header->m_magic != REPLAY_MAGIC || header->m_version != REPLAY_VERSION) {
+		ESP_LOGE(TAG, "'%s' is not a valid input recording", p_path);
+		SDL_free(data);
+		return FALSE;
+	}
+
+	// The events are used in place, right after the header
+	m_data = data;
+	m_events = (IsleReplayEvent*) (header + 1);
+	m_numEvents = (size - sizeof(*header)) / sizeof(IsleReplayEvent);
+	m_seed = header->m_seed;
+	m_mode = e_replay;
+
+	ESP_LOGI(TAG, "Replaying %u input events from '%s' (seed %" PRIu32 ")", (unsigned) m_numEvents, p_path, m_seed);
+	return TRUE;
+}
+
+// Writing to the SD card takes long enough to shift frame timing, and with
+// it the frame numbers being recorded, so events are kept in memory and only
+// written out here.
+void IsleReplay::Stop(MxU32 p_frame)
+{
+	if (m_mode == e_record) {
+		IsleReplayEvent end = {};
+		end.m_kind = IsleReplayEvent::e_end;
+		Record(p_frame, end);
+	}
+
+	// Record() turns recording off if it runs out of memory
+	if (m_mode == e_record) {
+		size_t size = m_numRecorded * sizeof(IsleReplayEvent);
+		if (SDL_WriteIO(m_file, m_recorded, size) != size) {
+			ESP_LOGE(TAG, "Failed to write input recording: %s", SDL_GetError());
+		}
+		else {
+			ESP_LOGI(TAG, "Recorded %u input events", (unsigned) m_numRecorded);
+		}
+	}
+
+	if (m_file) {
+		SDL_CloseIO(m_file);
+		m_file = NULL;
+	}
+
+	SDL_free(m_recorded);
+	m_recorded = NULL;
+	m_numRecorded = 0;
+	m_recordCapacity = 0;
+	m_mode = e_off;
+}
+
+void IsleReplay::Record(MxU32 p_frame, const IsleReplayEvent& p_event)
+{
+	if (m_mode != e_record) {
+		return;
+	}
+
+	if (m_numRecorded == m_recordCapacity) {
+		size_t capacity = m_recordCapacity ? m_recordCapacity * 2 : REPLAY_RECORD_CAPACITY;
+		IsleReplayEvent* recorded =
+			(IsleReplayEvent*) SDL_realloc(m_recorded, capacity * sizeof(IsleReplayEvent));
+		if (!recorded) {
+			ESP_LOGE(TAG, "Out of memory for input recording, stopping");
+			SDL_free(m_recorded);
+			m_recorded = NULL;
+			m_numRecorded = 0;
+			m_recordCapacity = 0;
+			SDL_CloseIO(m_file);
+			m_file = NULL;
+			m_mode = e_off;
+			return;
+		}
+
+		m_recorded = recorded;
+		m_recordCapacity = capacity;
+	}
+
+	IsleReplayEvent& event = m_recorded[m_numRecorded++];
+	event = p_event;
+	event.m_frame = p_frame;
+}
+
+// Returns the next recorded event due on or before p_frame, or NULL if there
+// is none yet. The end marker is consumed here and finishes the replay.
+const IsleReplayEvent* IsleReplay::Next(MxU32 p_frame)
+{
+	if (m_mode != e_replay || m_finished) {
+		return NULL;
+	}
+
+	if (m_nextEvent >= m_numEvents) {
+		m_finished = TRUE;
+		return NULL;
+	}
+
+	const IsleReplayEvent* event = &m_events[m_nextEvent];
+	if (event->m_frame > p_frame) {
+		return NULL;
+	}
+
+	m_nextEvent++;
+
+	if (event->m_kind == IsleReplayEvent::e_end) {
+		m_finished = TRUE;
+		return NULL;
+	}
+
+	return event;
+}
@@ -0,0 +1,67 @@
+#ifndef ISLEREPLAY_H
+#define ISLEREPLAY_H
+
+#include "mxtypes.h"
+
+#include <SDL3/SDL.h>
+
+struct IsleReplayEvent {
+	enum Kind {
+		e_fingerDown,
+		e_fingerUp,
+		e_fingerMotion,
+		e_timer,
+		e_end
+	};
+
+	MxU32 m_frame;
+	MxU32 m_kind;
+	MxS32 m_code;
+	float m_x;
+	float m_y;
+};
+
+// [library:replay]
+// Records the input that reaches the game together with the frame it arrived
+// on, and feeds it back on the same frames with the same random seed, so one
+// recorded session can be replayed on every build.
+class IsleReplay {
+public:
+	enum Mode {
+		e_off,
+		e_record,
+		e_replay
+	};
+
+	IsleReplay();
+	~IsleReplay();
+
+	MxBool StartRecording(const char* p_path);
+	MxBool StartReplay(const char* p_path);
+	void Stop(MxU32 p_frame);
+
+	void Record(MxU32 p_frame, const IsleReplayEvent& p_event);
+	const IsleReplayEvent* Next(MxU32 p_frame);
+
+	Mode GetMode() { return m_mode; }
+	MxBool IsReplaying() { return m_mode == e_replay; }
+	MxBool IsFinished() { return m_finished; }
+	MxU32 GetSeed() { return m_seed; }
+
+private:
+	Mode m_mode;
+	MxU32 m_seed;
+	SDL_IOStream* m_file;
+	MxU8* m_data;
+	IsleReplayEvent* m_events;
+	size_t m_numEvents;
+	size_t m_nextEvent;
+	IsleReplayEvent* m_recorded;
+	size_t m_numRecorded;
+	size_t m_recordCapacity;
+	MxBool m_finished;
+};
+
+extern IsleReplay g_replay;
+
+#endif // ISLEREPLAY_H
@@ -8,6 +8,7 @@
 #include "esp_system.h"
 
 #include "isleapp.h"
+#include "isleassets.h"
 
 // Just in case if someone accidentally enabled this and wiped everything by accident.
 #ifdef CONFIG_BSP_SD_FORMAT_ON_MOUNT_FAIL
@@ -31,6 +32,11 @@ void app_main(void)
         return;
     }
 
+#ifdef CONFIG_ISLE_FLASH_ASSETS
+    /* Optional, assets missing from flash keep coming from the SD card */
+    isle_assets_mount();
+#endif
+
     pthread_attr_init(&attr);
     pthread_attr_setstacksize(&attr, 8192);  // Set the stack size for the thread
 
@@ -51,6 +57,10 @@ done:
      * After the game has finished (or failed), we'll unmount everything and
      * do nothing..
      */
+#ifdef CONFIG_ISLE_FLASH_ASSETS
+    isle_assets_unmount();
+#endif
+
     eret = bsp_sdcard_unmount();
     if (eret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to unmount SD card %s", esp_err_to_name(eret));
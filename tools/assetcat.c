@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+
+/*
+ * Host-side check of an image built by tools/mkassets.py. It goes through
+ * the same lookup code the game uses (main/isleassets.c, with its host
+ * stand-in for the flash mapping) and writes the asset to stdout:
+ *
+ *     cc -Imain -o assetcat tools/assetcat.c main/isleassets.c
+ *     ISLE_ASSETS_IMAGE=assets.bin ./assetcat /LEGO/data/WORLD.WDB | cmp - WORLD.WDB
+ */
+
+#include <stdio.h>
+
+#include "isleassets.h"
+
+int main(int argc, char **argv)
+{
+    const void *data;
+    size_t size;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: ISLE_ASSETS_IMAGE=<image> %s <game path>\n", argv[0]);
+        return 2;
+    }
+
+    if (isle_assets_mount() < 0) {
+        return 1;
+    }
+
+    data = isle_assets_find(argv[1], &size);
+    if (!data) {
+        fprintf(stderr, "%s: not found\n", argv[1]);
+        isle_assets_unmount();
+        return 1;
+    }
+
+    fwrite(data, 1, size, stdout);
+    isle_assets_unmount();
+    return 0;
+}
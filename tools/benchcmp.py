@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""
+Compares benchmark results against a stored baseline and fails if any
+metric regressed by more than the threshold.
+
+Results are the "BENCH {...}" lines printed by IsleProfiler::Report() at
+the end of a run (typically an "Input Replay" session). Either a raw JSON
+file or a captured serial log can be given. Single runs are noisy, so pass
+several; the median of each metric is compared:
+
+    tools/benchcmp.py baseline.json run1.log run2.log run3.log
+
+A metric only counts as regressed if it got worse by more than --threshold
+percent *and* by more than its absolute noise floor (--noise-us for
+timings, --noise-bytes for memory).
+
+Use --write-baseline to store the median of the given runs as the new
+baseline.
+"""
+
+import argparse
+import json
+import re
+import statistics
+import sys
+
+BENCH_RE = re.compile(r"BENCH (\{.*?\})")
+
+# Not a measurement, only used to check that runs are comparable
+INFO_KEYS = ("frames",)
+
+# Runs recommended for a stable median
+MIN_RUNS = 3
+
+
+def load_results(path):
+    with open(path, "r", errors="replace") as f:
+        text = f.read()
+
+    matches = BENCH_RE.findall(text)
+    if matches:
+        # The last report in a log is the one for the whole run
+        return json.loads(matches[-1])
+
+    return json.loads(text)
+
+
+def median_results(runs):
+    keys = set()
+    for run in runs:
+        keys.update(run)
+
+    result = {}
+    for key in keys:
+        values = [run[key] for run in runs if key in run]
+        if len(values) == len(runs):
+            result[key] = statistics.median(values)
+
+    return result
+
+
+def noise_floor(key, args):
+    if key.endswith("_us"):
+        return args.noise_us
+    if key == "peak_heap":
+        return args.noise_bytes
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare LEGO Island benchmark results")
+    parser.add_argument("baseline", help="baseline results (JSON)")
+    parser.add_argument("runs", nargs="+", help="results of the current build (JSON or logs with a BENCH line)")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed regression in percent")
+    parser.add_argument("--noise-us", type=float, default=500, help="ignore timing changes up to this many us")
+    parser.add_argument("--noise-bytes", type=float, default=4096, help="ignore memory changes up to this many bytes")
+    parser.add_argument("--write-baseline", action="store_true", help="store the current median as the baseline")
+    args = parser.parse_args()
+
+    if len(args.runs) < MIN_RUNS:
+        print("warning: only %d run(s), use at least %d for a stable median" % (len(args.runs), MIN_RUNS))
+
+    current = median_results([load_results(path) for path in args.runs])
+
+    if args.write_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(current, f, indent=4, sort_keys=True)
+            f.write("\n")
+        print("Wrote median of %d run(s) to %s" % (len(args.runs), args.baseline))
+        return 0
+
+    baseline = load_results(args.baseline)
+
+    if baseline.get("frames") != current.get("frames"):
+        print("warning: frame count differs (%s vs %s), was the same recording replayed?"
+              % (baseline.get("frames"), current.get("frames")))
+
+    regressions = 0
+    for key in sorted(baseline):
+        if key in INFO_KEYS:
+            continue
+
+        if key not in current:
+            print("%-20s missing from current results" % key)
+            regressions += 1
+            continue
+
+        old = baseline[key]
+        new = current[key]
+        change = (new - old) * 100.0 / old if old else (0.0 if new == old else float("inf"))
+        failed = change > args.threshold and new - old > noise_floor(key, args)
+
+        print("%-20s %12s -> %-12s %+7.1f%%%s" % (key, old, new, change, "  REGRESSED" if failed else ""))
+        regressions += failed
+
+    if regressions:
+        print("%d metric(s) regressed by more than %.1f%%" % (regressions, args.threshold))
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
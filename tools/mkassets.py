@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""
+Builds the image for the "assets" flash partition (see main/isleassets.h).
+
+Small, frequently read game files can be stored in flash and mapped with
+isle_assets_find() instead of going through FAT on the SD card. Nothing in
+the game reads from the image yet; every file still comes from the SD card.
+Paths are given relative to the game data directory, e.g.:
+
+    tools/mkassets.py -d /path/to/game -o assets.bin \\
+        /LEGO/data/WORLD.WDB /LEGO/data/ACT1INF.DTA
+
+Flash the result with the following, and enable CONFIG_ISLE_FLASH_ASSETS:
+
+    parttool.py write_partition --partition-name=assets --input=assets.bin
+
+tools/assetcat.c can be used to check an image on the host.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x414C5349  # "ISLA"
+VERSION = 1
+PATH_MAX = 64
+ALIGN = 4
+
+HEADER = struct.Struct("<IIII")
+ENTRY = struct.Struct("<%dsII" % PATH_MAX)
+
+# Matches the partition size in partitions.csv
+DEFAULT_MAX_SIZE = 12 * 1024 * 1024
+
+
+def align(value):
+    return (value + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build the LEGO Island flash asset image")
+    parser.add_argument("-d", "--data-dir", required=True, help="game data directory (contains LEGO/)")
+    parser.add_argument("-o", "--output", required=True, help="output image")
+    parser.add_argument("--max-size", type=int, default=DEFAULT_MAX_SIZE, help="partition size in bytes")
+    parser.add_argument("files", nargs="+", help="game paths to include, e.g. /LEGO/data/WORLD.WDB")
+    args = parser.parse_args()
+
+    blobs = []
+    for path in args.files:
+        name = "/" + path.replace("\\", "/").lstrip("/")
+        if len(name.encode()) > PATH_MAX:
+            sys.exit("%s: path longer than %d bytes" % (name, PATH_MAX))
+
+        with open(os.path.join(args.data_dir, name.lstrip("/")), "rb") as f:
+            blobs.append((name, f.read()))
+
+    offset = align(HEADER.size + ENTRY.size * len(blobs))
+    entries = []
+    for name, data in blobs:
+        entries.append(ENTRY.pack(name.encode(), offset, len(data)))
+        offset = align(offset + len(data))
+
+    if offset > args.max_size:
+        sys.exit("image is %d bytes, partition only holds %d" % (offset, args.max_size))
+
+    with open(args.output, "wb") as out:
+        out.write(HEADER.pack(MAGIC, VERSION, len(blobs), offset))
+        for entry in entries:
+            out.write(entry)
+        for _, data in blobs:
+            out.write(b"\0" * (align(out.tell()) - out.tell()))
+            out.write(data)
+        out.write(b"\0" * (offset - out.tell()))
+
+    print("%s: %d files, %d bytes" % (args.output, len(blobs), offset))
+
+
+if __name__ == "__main__":
+    main()